@@ -0,0 +1,491 @@
+/**
+ *****************************************************************************
+ * @file ihex.hpp
+ * @brief constexpr-Variante der IHEX-Lib für C++17
+ * @author Roman Buchert (roman.buchert@googlemail.com)
+ * Hier stehen Parser, Prüfsummenberechnung und Encoder als constexpr-
+ * Funktionen. Damit lassen sich Intel-Hex-Daten (z.B. aus einem
+ * String-Literal oder per #embed eingebunden) bereits zur Übersetzungszeit
+ * prüfen und in ein std::array wandeln. Fehlerhafte Records (Prüfsumme,
+ * Format) führen bei der Auswertung zur Übersetzungszeit zu einem
+ * Compilerfehler, zur Laufzeit wird eine std::invalid_argument geworfen.
+ *
+ * Beispiel:
+ * @code
+ * constexpr std::string_view Boot = ":0400000001020304F2\r\n:00000001FF\r\n";
+ * constexpr auto Image = ihex::ihex2Bin<ihex::ihex2BinSize(Boot)>(Boot);
+ * @endcode
+ *****************************************************************************/
+#ifndef __IHEX_HPP__
+#define __IHEX_HPP__
+/*****************************************************************************/
+
+/*
+ *****************************************************************************
+ * INCLUDE-Dateien
+ *****************************************************************************/
+#include <ihex_types.h>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+/*****************************************************************************/
+
+namespace ihex
+{
+
+/**
+ ******************************************************************************
+ * @enum TRecordType
+ * @brief Verschiedene Typen der Hex-Records (entspricht rtData..rtSLA)
+ ******************************************************************************/
+enum TRecordType : __u8
+{
+	recData = 0,	///<Nutzdaten
+	recEOF  = 1,	///<Dateiende (End of File)
+	recXSA  = 2,	///<Segmentadresse für folgende Nutzdaten (Extended Address Segment)
+	recSSA  = 3,	///<Segmentierte Startadresse (Start Segment Address)
+	recXLA  = 4,	///<Höherwertige 16Bit der Adresse für folgende Nutzdaten (Extended Linear Address)
+	recSLA  = 5		///<Lineare Startadresse (Start Linear  Address)
+};
+/******************************************************************************/
+
+/**
+ ******************************************************************************
+ * @struct TRecord
+ * @brief Hex-Record mit max. MaxRecLen Byte Nutzdaten (vgl. THexRecord)
+ ******************************************************************************/
+template <std::size_t MaxRecLen = 255>
+struct TRecord
+{
+	static_assert((MaxRecLen > 0) && (MaxRecLen <= 255),
+				  "RecLen muss zwischen 1 und 255 liegen");
+
+	__u8 RecordMark;					///<Satzbeginn (":")
+	__u8 RecLen;						///<Datenlänge (Länge der Nutzdaten)
+	__u16 LoadOffset;					///<Ladeadresse (16-Bit-Adresse)
+	__u8 RecTyp;						///<Satztyp (Datensatztyp (0..5))
+	std::array<__u8, MaxRecLen> Data;	///<Nutzdaten (RecLen / max MaxRecLen Byte)
+	__u8 ChkSum;						///<Prüfsumme (Prüfsumme über Datensatz ohne RecordMark)
+};
+/******************************************************************************/
+
+/**
+ *****************************************************************************
+ * @brief Berechnet die Checksumme des HEX-Record (vgl. ihexCalcChksum)
+ * @param record Hexrecord
+ * @return berechnete Prüfsumme
+ *****************************************************************************/
+template <std::size_t MaxRecLen>
+constexpr __u8 calcChksum(const TRecord<MaxRecLen> &record)
+{
+	__u8 CheckSum = 0;
+
+	CheckSum += record.RecLen;
+	CheckSum += (__u8) (record.LoadOffset >> 8);
+	CheckSum += (__u8) (record.LoadOffset & 0xFF);
+	CheckSum += record.RecTyp;
+	for (std::size_t Cntr = 0; Cntr < record.RecLen; Cntr++)
+	{
+		CheckSum += record.Data[Cntr];
+	}
+
+	return ((__u8) -CheckSum);
+}
+/*****************************************************************************/
+
+/**
+ *****************************************************************************
+ * @brief Prüft die Checksumme des HEX-Record (vgl. ihexCheckChksum)
+ * @param record Hexrecord
+ * @return 0	: Prüfsumme stimmt. \n
+ * 		   !=0	: Prüfsumme ist falsch.
+ *****************************************************************************/
+template <std::size_t MaxRecLen>
+constexpr __s16 checkChksum(const TRecord<MaxRecLen> &record)
+{
+	return ((__s16) (calcChksum(record) - record.ChkSum));
+}
+/*****************************************************************************/
+
+namespace detail
+{
+
+/**
+ *****************************************************************************
+ * @brief Wandelt ein Hex-Zeichen in seinen Wert
+ * @param c Zeichen ('0'..'9', 'A'..'F', 'a'..'f')
+ * @return Wert des Zeichens, -1 bei ungültigem Zeichen
+ *****************************************************************************/
+constexpr __s16 hexDigit(char c)
+{
+	if ((c >= '0') && (c <= '9'))
+		return (c - '0');
+	if ((c >= 'A') && (c <= 'F'))
+		return (c - 'A' + 10);
+	if ((c >= 'a') && (c <= 'f'))
+		return (c - 'a' + 10);
+	return (-1);
+}
+/*****************************************************************************/
+
+/**
+ *****************************************************************************
+ * @brief Liest ein Byte (zwei Hex-Zeichen) aus einem String
+ * @param string String mit Hex-Zeichen
+ * @param Pos Position des ersten Zeichens
+ * @param *Value Zeiger auf das gelesene Byte
+ * @return 0: Alles o.k. \n
+ * 		   -EILSEQ		: String zu kurz oder ungültiges Zeichen.
+ *****************************************************************************/
+constexpr __s16 hexByte(std::string_view string, std::size_t Pos, __u8 *Value)
+{
+	if ((Pos + 2) > string.size())
+		return (-EILSEQ);
+
+	__s16 High = hexDigit(string[Pos]);
+	__s16 Low = hexDigit(string[Pos + 1]);
+	if ((High < 0) || (Low < 0))
+		return (-EILSEQ);
+
+	*Value = (__u8) ((High << 4) | Low);
+	return (0);
+}
+/*****************************************************************************/
+
+/**
+ *****************************************************************************
+ * @brief Schreibt ein Byte als zwei Hex-Zeichen (Großbuchstaben)
+ * @param Value Byte
+ * @param *outBuf Zeiger auf Ausgabepuffer (mind. 2 Zeichen)
+ * @return Zeiger hinter das letzte geschriebene Zeichen
+ *****************************************************************************/
+constexpr char *putHexByte(__u8 Value, char *outBuf)
+{
+	constexpr char Digits[] = "0123456789ABCDEF";
+	*outBuf++ = Digits[Value >> 4];
+	*outBuf++ = Digits[Value & 0x0F];
+	return (outBuf);
+}
+/*****************************************************************************/
+
+/**
+ *****************************************************************************
+ * @brief Wirft zu einem Fehlercode der IHEX-Lib eine Exception.
+ * In einem konstanten Ausdruck wird daraus ein Compilerfehler.
+ * @param RetVal Fehlercode (0: keine Exception)
+ *****************************************************************************/
+constexpr void raise(__s16 RetVal)
+{
+	switch (RetVal)
+	{
+	case 0:
+		break;
+	case -EILSEQ:
+		throw std::invalid_argument("ihex: ungültiger Record oder falsche Prüfsumme");
+	case -ENOSYS:
+		throw std::invalid_argument("ihex: Datensatztyp nicht unterstützt");
+	case -ENOMEM:
+		throw std::invalid_argument("ihex: Ausgabepuffer zu klein");
+	default:
+		throw std::invalid_argument("ihex: unbekannter Fehler");
+	}
+}
+/*****************************************************************************/
+
+} //namespace detail
+
+/**
+ *****************************************************************************
+ * @brief Erstellt aus einem Hex-Record-String eine Hex-Record-Struktur
+ * (vgl. ihexString2Record). Die Prüfsumme wird nicht geprüft.
+ * @param string String mit dem Hex-Record (beginnend mit ':')
+ * @param *record Zeiger auf Datensatz mit dem Hex-Record
+ * @param *RecordSize Zeiger auf eine Variable für die Anzahl gelesener Zeichen
+ * (darf NULL sein)
+ * @return 	0: Alles o.k.\n
+ * 		   -EILSEQ		: ungültiger Record oder RecLen > MaxRecLen.
+ *****************************************************************************/
+template <std::size_t MaxRecLen>
+constexpr __s16 string2Record(std::string_view string, TRecord<MaxRecLen> *record,
+							  std::size_t *RecordSize = nullptr)
+{
+	__u8 High = 0;
+	__u8 Low = 0;
+
+	if (string.empty() || (string[0] != ':'))
+		return (-EILSEQ);
+	record->RecordMark = (__u8) string[0];
+
+	//Datenlänge, Load Offset und Recordtype setzen
+	if ((detail::hexByte(string, 1, &record->RecLen) != 0) ||
+		(detail::hexByte(string, 3, &High) != 0) ||
+		(detail::hexByte(string, 5, &Low) != 0) ||
+		(detail::hexByte(string, 7, &record->RecTyp) != 0))
+		return (-EILSEQ);
+	record->LoadOffset = (__u16) ((High << 8) | Low);
+
+	if (record->RecLen > MaxRecLen)
+		return (-EILSEQ);
+
+	//Daten füllen
+	std::size_t Pos = 9;
+	for (std::size_t Cntr = 0; Cntr < record->RecLen; Cntr++, Pos += 2)
+	{
+		if (detail::hexByte(string, Pos, &record->Data[Cntr]) != 0)
+			return (-EILSEQ);
+	}
+
+	//Checksumme setzen
+	if (detail::hexByte(string, Pos, &record->ChkSum) != 0)
+		return (-EILSEQ);
+
+	if (RecordSize != nullptr)
+		*RecordSize = Pos + 2;
+	return (0);
+}
+/*****************************************************************************/
+
+/**
+ *****************************************************************************
+ * @brief Erstellt aus einer Hex-Record-Struktur einen Hex-String
+ * (vgl. ihexRecord2String). Es wird kein Nullzeichen angehängt.
+ * @param record Datensatz mit dem Hex-Record
+ * @param *outBuf Zeiger auf einen Puffer mit mind. 13 + 2 * RecLen Zeichen
+ * @return Zeiger hinter das letzte geschriebene Zeichen
+ *****************************************************************************/
+template <std::size_t MaxRecLen>
+constexpr char *record2String(const TRecord<MaxRecLen> &record, char *outBuf)
+{
+	*outBuf++ = ':';
+	outBuf = detail::putHexByte(record.RecLen, outBuf);
+	outBuf = detail::putHexByte((__u8) (record.LoadOffset >> 8), outBuf);
+	outBuf = detail::putHexByte((__u8) (record.LoadOffset & 0xFF), outBuf);
+	outBuf = detail::putHexByte(record.RecTyp, outBuf);
+	//Daten hinzufügen
+	for (std::size_t Cntr = 0; Cntr < record.RecLen; Cntr++)
+	{
+		outBuf = detail::putHexByte(record.Data[Cntr], outBuf);
+	}
+
+	//CRC und Endekennung hinzufügen
+	outBuf = detail::putHexByte(record.ChkSum, outBuf);
+	*outBuf++ = '\r';
+	*outBuf++ = '\n';
+	return (outBuf);
+}
+/*****************************************************************************/
+
+/**
+ *****************************************************************************
+ * @brief Wandelt einen Hex-String in einen Binärpuffer um (vgl. ihexIhex2Bin).
+ * Es werden nur folgende Datensatztypen erkannt:\n
+ * 00:	DATA	: Datenrecord\n
+ * 01:	EOF		: Dateiende\n
+ * 02:	XSA		: Segmentadresse für folgende Nutzdaten\n
+ * 04:	LSA		: Lineare Startadresse für folgende Nutzdaten.
+ *
+ * Leerzeichen und Zeilenumbrüche zwischen den Records werden übersprungen,
+ * ein Nullzeichen beendet die Verarbeitung. Nicht belegte Adressen werden
+ * mit 0x00 gefüllt.
+ * @param inBuf Hex-String
+ * @param *outBuf Zeiger auf einen Puffer für die Binärdaten (darf NULL sein,
+ * dann wird nur die benötigte Größe ermittelt)
+ * @param outBufMaxSize Größe des Puffers outBuf
+ * @param *outBufSize Zeiger auf eine Variable für die Größe der Binärdaten
+ * @return 0: Alles o.k. \n
+ * 		   -EILSEQ		: ungültiger Record oder falsche Prüfsumme. \n
+ * 		   -ENOSYS		: Datensatztyp wird nicht unterstützt. \n
+ * 		   -ENOMEM		: outBuf ist zu klein.
+ *****************************************************************************/
+constexpr __s16 ihex2Bin(std::string_view inBuf, __u8 *outBuf,
+						 std::size_t outBufMaxSize, std::size_t *outBufSize)
+{
+	std::size_t AdrOffset = 0;	//Adressoffset
+	std::size_t LastAddr = 0;
+	std::size_t BufSize = 0;
+	std::size_t Pos = 0;
+	TRecord<> Record{};
+
+	while ((Pos < inBuf.size()) && (inBuf[Pos] != '\0'))
+	{
+		//Trennzeichen zwischen den Records überspringen
+		char c = inBuf[Pos];
+		if ((c == '\r') || (c == '\n') || (c == ' ') || (c == '\t'))
+		{
+			Pos++;
+			continue;
+		}
+
+		std::size_t RecordSize = 0;
+		if (string2Record(inBuf.substr(Pos), &Record, &RecordSize) != 0)
+			return (-EILSEQ);
+		Pos += RecordSize;
+
+		if (checkChksum(Record) != 0)
+			return (-EILSEQ);
+
+		//Datensatztyp bearbeiten
+		switch (Record.RecTyp)
+		{
+		case recData:	//Datenrecord bearbeiten
+			LastAddr = AdrOffset + Record.LoadOffset + Record.RecLen;
+			if (BufSize < LastAddr)
+			{
+				if ((outBuf != nullptr) && (LastAddr > outBufMaxSize))
+					return (-ENOMEM);
+				for (std::size_t Cntr = BufSize; (outBuf != nullptr) && (Cntr < LastAddr); Cntr++)
+					outBuf[Cntr] = 0x00;
+				BufSize = LastAddr;
+			}
+			for (std::size_t Cntr = 0; (outBuf != nullptr) && (Cntr < Record.RecLen); Cntr++)
+				outBuf[AdrOffset + Record.LoadOffset + Cntr] = Record.Data[Cntr];
+			break;
+
+		case recEOF:	//EOF
+			*outBufSize = BufSize;
+			return (0);
+
+		case recXSA:	//Segmentladeadresse setzen
+			if (Record.RecLen != 2)
+				return (-EILSEQ);
+			AdrOffset = (std::size_t) ((Record.Data[0] << 8) | Record.Data[1]) << 4;
+			break;
+
+		case recXLA:	//Linear Startadresse setzen
+			if (Record.RecLen != 2)
+				return (-EILSEQ);
+			AdrOffset = (std::size_t) ((Record.Data[0] << 8) | Record.Data[1]) << 16;
+			break;
+
+		case recSSA:	//Start Segment Adress Record
+		case recSLA:
+		default:
+			return (-ENOSYS);
+		}
+	}
+
+	*outBufSize = BufSize;
+	return (0);
+}
+/*****************************************************************************/
+
+/**
+ *****************************************************************************
+ * @brief Ermittelt die Größe der Binärdaten eines Hex-Strings
+ * @param inBuf Hex-String
+ * @return Größe der Binärdaten (Template-Parameter für ihex2Bin<>())
+ *****************************************************************************/
+constexpr std::size_t ihex2BinSize(std::string_view inBuf)
+{
+	std::size_t Size = 0;
+	__s16 RetVal = ihex2Bin(inBuf, nullptr, 0, &Size);
+	detail::raise(RetVal);
+	return (Size);
+}
+/*****************************************************************************/
+
+/**
+ *****************************************************************************
+ * @brief Wandelt einen Hex-String in ein std::array mit den Binärdaten um.
+ * Ist OutSize größer als die Binärdaten, wird mit 0x00 aufgefüllt.
+ * @param inBuf Hex-String
+ * @return Binärdaten
+ *****************************************************************************/
+template <std::size_t OutSize>
+constexpr std::array<__u8, OutSize> ihex2Bin(std::string_view inBuf)
+{
+	std::array<__u8, OutSize> Buffer{};
+	std::size_t Size = 0;
+	__s16 RetVal = ihex2Bin(inBuf, Buffer.data(), Buffer.size(), &Size);
+	detail::raise(RetVal);
+	return (Buffer);
+}
+/*****************************************************************************/
+
+/**
+ *****************************************************************************
+ * @brief Berechnet die Länge des Hex-Strings, den bin2Ihex<>() erzeugt
+ * (inkl. abschließendem Nullzeichen)
+ * @param inBufSize Größe der Binärdaten
+ * @param DataLen max. Länge der Daten je Record
+ * @return Länge des Hex-Strings
+ *****************************************************************************/
+constexpr std::size_t bin2IhexSize(std::size_t inBufSize, std::size_t DataLen)
+{
+	std::size_t Size = 13 + 1;	//EOF-Record und Nullzeichen
+	for (std::size_t Segment = 0; Segment < inBufSize; Segment += 0x10000)
+	{
+		std::size_t SegmentSize = inBufSize - Segment;
+		if (SegmentSize > 0x10000)
+			SegmentSize = 0x10000;
+		Size += 13 + 4;	//XLA-Record
+		Size += 13 * ((SegmentSize + DataLen - 1) / DataLen) + 2 * SegmentSize;
+	}
+	return (Size);
+}
+/*****************************************************************************/
+
+/**
+ *****************************************************************************
+ * @brief Wandelt Binärdaten in einen nullterminierten Hex-String
+ * (vgl. ihexBin2Ihex). Jedes 64k-Segment beginnt mit einem XLA-Record,
+ * ein angefangener Datenrecord am Ende wird ebenfalls ausgegeben.
+ * @tparam DataLen max. Länge der Daten je Record
+ * @param inBuf Binärdaten
+ * @return Hex-String mit abschließendem Nullzeichen
+ *****************************************************************************/
+template <std::size_t DataLen, std::size_t InSize>
+constexpr std::array<char, bin2IhexSize(InSize, DataLen)>
+bin2Ihex(const std::array<__u8, InSize> &inBuf)
+{
+	static_assert((DataLen > 0) && (DataLen <= 255),
+				  "DataLen muss zwischen 1 und 255 liegen");
+
+	std::array<char, bin2IhexSize(InSize, DataLen)> outBuf{};
+	char *OutPtr = outBuf.data();
+	TRecord<(DataLen < 2) ? 2 : DataLen> Record{};
+
+	Record.RecordMark = ':';
+	for (std::size_t Cntr = 0; Cntr < InSize; )
+	{
+		//Erstelle den Segment Adress Record
+		if ((Cntr & 0xFFFF) == 0)
+		{
+			Record.RecLen = 0x02;
+			Record.LoadOffset = 0x0000;
+			Record.RecTyp = recXLA;
+			Record.Data[0] = (__u8) (Cntr >> 24);
+			Record.Data[1] = (__u8) (Cntr >> 16);
+			Record.ChkSum = calcChksum(Record);
+			OutPtr = record2String(Record, OutPtr);
+		}
+
+		//Fülle Daten bis Datensatz oder Segment voll
+		Record.LoadOffset = (__u16) (Cntr & 0xFFFF);
+		Record.RecTyp = recData;
+		Record.RecLen = 0;
+		do
+		{
+			Record.Data[Record.RecLen++] = inBuf[Cntr++];
+		} while ((Record.RecLen < DataLen) && (Cntr < InSize) && ((Cntr & 0xFFFF) != 0));
+		Record.ChkSum = calcChksum(Record);
+		OutPtr = record2String(Record, OutPtr);
+	}
+
+	//Enderecord schreiben
+	Record.RecLen = 0x00;
+	Record.LoadOffset = 0x0000;
+	Record.RecTyp = recEOF;
+	Record.ChkSum = calcChksum(Record);
+	OutPtr = record2String(Record, OutPtr);
+	*OutPtr = '\0';
+
+	return (outBuf);
+}
+/*****************************************************************************/
+
+} //namespace ihex
+
+#endif//__IHEX_HPP__
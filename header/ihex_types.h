@@ -96,7 +96,7 @@ typedef volatile signed long long const __vsc64;
  * @enum bool
  * @brief Typdefinitionen TRUE / FALSE
  ******************************************************************************/
-#ifndef bool
+#if !defined(bool) && !defined(__cplusplus)
 typedef enum {FALSE = 0, TRUE = 1} bool;
 #endif
 /******************************************************************************/